@@ -15,18 +15,21 @@
  * OBJETIVO:
  * Este programa tem como objetivo implementar e comparar diferentes algoritmos de 
  * ordenação aplicados a um dataset de jogadores de futebol. O sistema permite ao 
- * usuário escolher entre três métodos de ordenação (Bubble Sort, Merge Sort e 
- * Bucket Sort) para ordenar os jogadores por nome, com suporte a caracteres 
- * acentuados. Para cada ordenação, são exibidas métricas detalhadas de desempenho
- * incluindo tempo de execução, número de operações e consumo de memória.
+ * usuário escolher entre métodos de ordenação (Bubble Sort, Merge Sort, Bucket
+ * Sort, Counting Sort e Radix Sort) para ordenar os jogadores por nome, idade ou
+ * clube, com suporte a caracteres acentuados. Para cada ordenação, são exibidas
+ * métricas detalhadas de desempenho incluindo tempo de execução, número de
+ * operações e consumo de memória.
  * 
  * FUNCIONAMENTO:
  * 1. Carrega dados de jogadores a partir de um arquivo CSV
- * 2. Oferece menu interativo com três algoritmos de ordenação
+ * 2. Oferece menu interativo com os algoritmos de ordenação (comparação e lineares)
  * 3. Executa a ordenação selecionada e exibe o vetor completo ordenado
  * 4. Apresenta métricas de desempenho detalhadas
  * 5. Permite salvar o resultado em arquivo CSV
  * 6. Suporta caracteres acentuados através do locale pt_BR.UTF-8
+ * 7. Modo servidor (--servidor) que mantém os dados carregados e responde
+ *    consultas por um socket Unix local; modo cliente (--cliente) para testá-lo
  * 
  * =====================================================================================
  */
@@ -37,6 +40,17 @@
 #include <stdlib.h>
 #include <time.h>
 #include <locale.h>  // Para suporte a caracteres acentuados
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>     // Pool de threads do modo servidor
+#include <sys/socket.h>
+#include <sys/un.h>      // Socket Unix local
+#include <sys/time.h>    // Tempo limite de conexões ociosas
+#include <stdint.h>
+#include <poll.h>
+#include <fcntl.h>
 
 // ============================================================================
 // ESTRUTURAS DE DADOS
@@ -53,6 +67,7 @@ typedef struct p
     char nationalite[100];   // Nacionalidade
     char team[100];          // Clube atual
     int age;                 // Idade
+    int id;                  // Posição no vetor carregado (identifica o jogador após ordenar)
     struct p *prox;          // Ponteiro para próximo (uso em listas)
 } player;
 
@@ -65,6 +80,10 @@ typedef struct {
     long long comparacoes;   // Número de comparações realizadas
     long long trocas;        // Número de trocas/operações de movimentação
     double memoria_gasta;    // Memória utilizada em MB
+    int passadas;            // Passadas sobre os dados (ordenações lineares)
+    bool do_cache;           // Resultado servido pelo cache, sem ordenar
+    long long acertos_cache; // Acertos acumulados do cache de ordenações
+    long long falhas_cache;  // Falhas acumuladas do cache de ordenações
 } Metricas;
 
 // ============================================================================
@@ -74,6 +93,157 @@ typedef struct {
 long long comparacoes_count = 0;  // Contador global de comparações
 long long trocas_count = 0;       // Contador global de trocas
 
+// ============================================================================
+// RASTREAMENTO DE FASES (TRACE)
+// ============================================================================
+
+/*
+ * Pontos de rastreamento com escopo: TRACE_ESCOPO("nome") mede do ponto onde
+ * aparece até o fim do bloco. Os eventos vão para um buffer circular por
+ * thread e são exportados no formato JSON do Chrome (chrome://tracing ou
+ * ui.perfetto.dev). Só existem quando compilado com -DTRACE; caso contrário
+ * as macros não geram código.
+ */
+
+/**
+ * Retorna o instante atual em microssegundos (relógio monotônico)
+ */
+double agoraMicrossegundos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+#ifdef TRACE
+
+#define EVENTOS_POR_THREAD 65536  // Ao encher, os eventos mais antigos são sobrescritos
+
+typedef struct {
+    const char *nome;
+    const char *nomeArg;     // Nome do argumento opcional (NULL se não houver)
+    long long valorArg;
+    double inicio;           // Microssegundos
+    double duracao;
+} EventoTrace;
+
+typedef struct BufferTrace {
+    EventoTrace eventos[EVENTOS_POR_THREAD];
+    long long total;         // Eventos já registrados (inclusive sobrescritos)
+    int tid;
+    struct BufferTrace *prox;
+} BufferTrace;
+
+/**
+ * Escopo aberto por TRACE_ESCOPO; fecharEscopoTrace é chamada
+ * automaticamente (atributo cleanup) quando a variável sai de escopo
+ */
+typedef struct {
+    const char *nome;
+    const char *nomeArg;
+    long long valorArg;
+    double inicio;
+} EscopoTrace;
+
+BufferTrace *buffersTrace = NULL;  // Lista de buffers de todas as threads
+pthread_mutex_t travaTrace = PTHREAD_MUTEX_INITIALIZER;
+int proximoTid = 1;
+__thread BufferTrace *bufferThread = NULL;
+
+/**
+ * Retorna o buffer da thread atual, criando-o no primeiro uso
+ */
+BufferTrace *obterBufferTrace() {
+    if (bufferThread == NULL) {
+        bufferThread = (BufferTrace*)calloc(1, sizeof(BufferTrace));
+        if (bufferThread == NULL) return NULL;
+        
+        pthread_mutex_lock(&travaTrace);
+        bufferThread->tid = proximoTid++;
+        bufferThread->prox = buffersTrace;
+        buffersTrace = bufferThread;
+        pthread_mutex_unlock(&travaTrace);
+    }
+    return bufferThread;
+}
+
+void fecharEscopoTrace(EscopoTrace *escopo) {
+    double fim = agoraMicrossegundos();
+    BufferTrace *buffer = obterBufferTrace();
+    if (buffer == NULL) return;
+    
+    EventoTrace *e = &buffer->eventos[buffer->total % EVENTOS_POR_THREAD];
+    e->nome = escopo->nome;
+    e->nomeArg = escopo->nomeArg;
+    e->valorArg = escopo->valorArg;
+    e->inicio = escopo->inicio;
+    e->duracao = fim - escopo->inicio;
+    buffer->total++;
+}
+
+/**
+ * Exporta os eventos de todas as threads em JSON do Chrome e libera os buffers
+ * Deve ser chamada quando nenhuma outra thread estiver registrando eventos
+ * 
+ * @param filename Nome do arquivo de saída
+ */
+void exportarTrace(const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        printf("Erro ao criar arquivo %s\n", filename);
+        return;
+    }
+    
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool primeiro = true;
+    long long eventos = 0;
+    
+    pthread_mutex_lock(&travaTrace);
+    BufferTrace *buffer = buffersTrace;
+    while (buffer != NULL) {
+        long long n = buffer->total < EVENTOS_POR_THREAD ? buffer->total : EVENTOS_POR_THREAD;
+        for (long long i = buffer->total - n; i < buffer->total; i++) {
+            EventoTrace *e = &buffer->eventos[i % EVENTOS_POR_THREAD];
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    primeiro ? "" : ",\n", e->nome, buffer->tid, e->inicio, e->duracao);
+            if (e->nomeArg != NULL) {
+                fprintf(file, ",\"args\":{\"%s\":%lld}", e->nomeArg, e->valorArg);
+            }
+            fprintf(file, "}");
+            primeiro = false;
+        }
+        eventos += n;
+        
+        BufferTrace *proximo = buffer->prox;
+        free(buffer);
+        buffer = proximo;
+    }
+    buffersTrace = NULL;
+    bufferThread = NULL;
+    pthread_mutex_unlock(&travaTrace);
+    
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    printf("Trace salvo com sucesso: %s (%lld eventos)\n", filename, eventos);
+}
+
+#define ARQUIVO_TRACE "trace_ordenacao.json"
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_ESCOPO_ARG(nome, nomeArg, valor) \
+    EscopoTrace TRACE_CONCAT(escopoTrace_, __LINE__) __attribute__((cleanup(fecharEscopoTrace))) = \
+        {(nome), (nomeArg), (valor), agoraMicrossegundos()}
+#define TRACE_ESCOPO(nome) TRACE_ESCOPO_ARG(nome, NULL, 0)
+#define TRACE_EXPORTAR(arquivo) exportarTrace(arquivo)
+
+#else
+
+#define TRACE_ESCOPO_ARG(nome, nomeArg, valor) ((void)0)
+#define TRACE_ESCOPO(nome) ((void)0)
+#define TRACE_EXPORTAR(arquivo) ((void)0)
+
+#endif
+
 // ============================================================================
 // FUNÇÕES AUXILIARES E DE COMPARAÇÃO
 // ============================================================================
@@ -112,6 +282,7 @@ void trocarPlayers(player *a, player *b) {
  * @param n Número total de jogadores
  */
 void imprimirTodosJogadores(player *players, int n) {
+    TRACE_ESCOPO("imprimirTodosJogadores");
     printf("\n=== VETOR COMPLETO ORDENADO (%d jogadores) ===\n", n);
     for (int i = 0; i < n; i++) {
         // Formatação alinhada para melhor visualização
@@ -138,6 +309,11 @@ void exibirMetricas(Metricas metricas, const char *metodo) {
     printf("Operações de comparação:  %lld\n", metricas.comparacoes);
     printf("Operações de troca:       %lld\n", metricas.trocas);
     printf("Memória gasta:           %.6f MB\n", metricas.memoria_gasta);
+    if (metricas.passadas > 0) {
+        printf("Passadas sobre os dados:  %d\n", metricas.passadas);
+    }
+    printf("Origem do resultado:      %s\n", metricas.do_cache ? "cache" : "ordenação");
+    printf("Cache (acertos/falhas):   %lld / %lld\n", metricas.acertos_cache, metricas.falhas_cache);
     printf("==============================\n\n");
 }
 
@@ -154,8 +330,10 @@ void exibirMetricas(Metricas metricas, const char *metodo) {
  * @param players Vetor de jogadores a ser ordenado
  * @param n Tamanho do vetor
  * @param metricas Ponteiro para estrutura de métricas
+ * @return 1 (sempre conclui a ordenação)
  */
-void bubbleSort(player *players, int n, Metricas *metricas) {
+int bubbleSort(player *players, int n, Metricas *metricas) {
+    TRACE_ESCOPO_ARG("bubbleSort", "n", n);
     // Reinicia contadores para esta execução
     comparacoes_count = 0;
     trocas_count = 0;
@@ -174,6 +352,7 @@ void bubbleSort(player *players, int n, Metricas *metricas) {
     metricas->comparacoes = comparacoes_count;
     metricas->trocas = trocas_count;
     metricas->memoria_gasta = n * sizeof(player) / 1024.0 / 1024.0; // Calcula memória em MB
+    return 1;
 }
 
 /**
@@ -192,6 +371,7 @@ void bubbleSort(player *players, int n, Metricas *metricas) {
  * @param right Índice final do segundo subarray
  */
 void merge(player *players, int left, int mid, int right) {
+    TRACE_ESCOPO_ARG("merge", "tamanho", right - left + 1);
     int i, j, k;
     int n1 = mid - left + 1;  // Tamanho do primeiro subarray
     int n2 = right - mid;     // Tamanho do segundo subarray
@@ -251,15 +431,18 @@ void merge(player *players, int left, int mid, int right) {
  * @param players Vetor a ser ordenado
  * @param left Índice inicial
  * @param right Índice final
+ * @param profundidade Nível da recursão (0 na chamada inicial), usado no trace
  */
-void mergeSortRecursivo(player *players, int left, int right) {
+void mergeSortRecursivo(player *players, int left, int right, int profundidade) {
     if (left < right) {
+        TRACE_ESCOPO_ARG("mergeSortRecursivo", "profundidade", profundidade);
+        
         // Encontra o ponto médio
         int mid = left + (right - left) / 2;
         
         // Ordena primeira e segunda metades
-        mergeSortRecursivo(players, left, mid);
-        mergeSortRecursivo(players, mid + 1, right);
+        mergeSortRecursivo(players, left, mid, profundidade + 1);
+        mergeSortRecursivo(players, mid + 1, right, profundidade + 1);
         
         // Mescla as metades ordenadas
         merge(players, left, mid, right);
@@ -272,18 +455,21 @@ void mergeSortRecursivo(player *players, int left, int right) {
  * @param players Vetor de jogadores
  * @param n Tamanho do vetor
  * @param metricas Ponteiro para métricas
+ * @return 1 (sempre conclui a ordenação)
  */
-void mergeSort(player *players, int n, Metricas *metricas) {
+int mergeSort(player *players, int n, Metricas *metricas) {
+    TRACE_ESCOPO_ARG("mergeSort", "n", n);
     comparacoes_count = 0;
     trocas_count = 0;
     
     // Chama função recursiva
-    mergeSortRecursivo(players, 0, n - 1);
+    mergeSortRecursivo(players, 0, n - 1, 0);
     
     // Atualiza métricas
     metricas->comparacoes = comparacoes_count;
     metricas->trocas = trocas_count;
     metricas->memoria_gasta = (n * sizeof(player) * 2) / 1024.0 / 1024.0; // Considera arrays temporários
+    return 1;
 }
 
 /**
@@ -300,6 +486,7 @@ void mergeSort(player *players, int n, Metricas *metricas) {
  * @param str String a ser normalizada
  */
 void normalizarString(char *str) {
+    TRACE_ESCOPO("normalizarString");
     // Mapeamento de caracteres acentuados UTF-8 para equivalentes sem acento
     for (int i = 0; str[i]; i++) {
         switch ((unsigned char)str[i]) {
@@ -334,8 +521,10 @@ void normalizarString(char *str) {
  * @param players Vetor de jogadores
  * @param n Tamanho do vetor
  * @param metricas Ponteiro para métricas
+ * @return 1 (sempre conclui a ordenação)
  */
-void bucketSort(player *players, int n, Metricas *metricas) {
+int bucketSort(player *players, int n, Metricas *metricas) {
+    TRACE_ESCOPO_ARG("bucketSort", "n", n);
     comparacoes_count = 0;
     trocas_count = 0;
     
@@ -358,54 +547,64 @@ void bucketSort(player *players, int n, Metricas *metricas) {
     }
     
     // Fase de distribuição: coloca cada jogador no bucket correspondente
-    for (int i = 0; i < n; i++) {
-        char nome_normalizado[100];
-        strcpy(nome_normalizado, players[i].name);
-        normalizarString(nome_normalizado);  // Normaliza para lidar com acentos
-        
-        char primeiraLetra = nome_normalizado[0];
-        int bucketIndex;
-        
-        // Determina índice do bucket baseado na primeira letra
-        if (primeiraLetra >= 'a' && primeiraLetra <= 'z') {
-            bucketIndex = primeiraLetra - 'a';
-        } else if (primeiraLetra >= 'A' && primeiraLetra <= 'Z') {
-            bucketIndex = primeiraLetra - 'A';
-        } else {
-            bucketIndex = 0;  // Caracteres especiais vão para o bucket A
-        }
-        
-        // Verifica se precisa redimensionar o bucket
-        if (tamanhos[bucketIndex] >= capacidades[bucketIndex]) {
-            capacidades[bucketIndex] *= 2;  // Dobra a capacidade
-            buckets[bucketIndex] = (player*)realloc(buckets[bucketIndex], 
-                                                capacidades[bucketIndex] * sizeof(player));
-            memoria_buckets += capacidades[bucketIndex] / 2 * sizeof(player); // Memória adicional
+    {
+        TRACE_ESCOPO("bucketSort.distribuicao");
+        for (int i = 0; i < n; i++) {
+            char nome_normalizado[100];
+            strcpy(nome_normalizado, players[i].name);
+            normalizarString(nome_normalizado);  // Normaliza para lidar com acentos
+            
+            char primeiraLetra = nome_normalizado[0];
+            int bucketIndex;
+            
+            // Determina índice do bucket baseado na primeira letra
+            if (primeiraLetra >= 'a' && primeiraLetra <= 'z') {
+                bucketIndex = primeiraLetra - 'a';
+            } else if (primeiraLetra >= 'A' && primeiraLetra <= 'Z') {
+                bucketIndex = primeiraLetra - 'A';
+            } else {
+                bucketIndex = 0;  // Caracteres especiais vão para o bucket A
+            }
+            
+            // Verifica se precisa redimensionar o bucket
+            if (tamanhos[bucketIndex] >= capacidades[bucketIndex]) {
+                TRACE_ESCOPO("bucketSort.realloc");
+                capacidades[bucketIndex] *= 2;  // Dobra a capacidade
+                buckets[bucketIndex] = (player*)realloc(buckets[bucketIndex], 
+                                                    capacidades[bucketIndex] * sizeof(player));
+                memoria_buckets += capacidades[bucketIndex] / 2 * sizeof(player); // Memória adicional
+            }
+            
+            // Adiciona jogador ao bucket
+            buckets[bucketIndex][tamanhos[bucketIndex]] = players[i];
+            tamanhos[bucketIndex]++;
         }
-        
-        // Adiciona jogador ao bucket
-        buckets[bucketIndex][tamanhos[bucketIndex]] = players[i];
-        tamanhos[bucketIndex]++;
     }
     
     // Fase de ordenação: ordena cada bucket individualmente
-    Metricas metricas_bucket;
-    for (int i = 0; i < 26; i++) {
-        if (tamanhos[i] > 0) {
-            bubbleSort(buckets[i], tamanhos[i], &metricas_bucket);
-            // Acumula métricas de todos os buckets
-            comparacoes_count += metricas_bucket.comparacoes;
-            trocas_count += metricas_bucket.trocas;
+    {
+        TRACE_ESCOPO("bucketSort.ordenacao");
+        Metricas metricas_bucket;
+        for (int i = 0; i < 26; i++) {
+            if (tamanhos[i] > 0) {
+                bubbleSort(buckets[i], tamanhos[i], &metricas_bucket);
+                // Acumula métricas de todos os buckets
+                comparacoes_count += metricas_bucket.comparacoes;
+                trocas_count += metricas_bucket.trocas;
+            }
         }
     }
     
     // Fase de concatenação: junta todos os buckets ordenados no array original
-    int index = 0;
-    for (int i = 0; i < 26; i++) {
-        for (int j = 0; j < tamanhos[i]; j++) {
-            players[index++] = buckets[i][j];
+    {
+        TRACE_ESCOPO("bucketSort.concatenacao");
+        int index = 0;
+        for (int i = 0; i < 26; i++) {
+            for (int j = 0; j < tamanhos[i]; j++) {
+                players[index++] = buckets[i][j];
+            }
+            free(buckets[i]);  // Libera memória do bucket
         }
-        free(buckets[i]);  // Libera memória do bucket
     }
     
     // Libera estruturas auxiliares
@@ -417,266 +616,1902 @@ void bucketSort(player *players, int n, Metricas *metricas) {
     metricas->comparacoes = comparacoes_count;
     metricas->trocas = trocas_count;
     metricas->memoria_gasta = (n * sizeof(player) + memoria_buckets) / 1024.0 / 1024.0;
+    return 1;
 }
 
 // ============================================================================
-// FUNÇÕES DE ARQUIVO E INTERFACE
+// ORDENAÇÃO POR ÍNDICES (PERMUTAÇÕES)
 // ============================================================================
 
 /**
- * Função para salvar o vetor ordenado em arquivo CSV
+ * Campos pelos quais o vetor de jogadores pode ser ordenado
+ */
+typedef enum {
+    CHAVE_NOME = 0,
+    CHAVE_POSICAO,
+    CHAVE_NACIONALIDADE,
+    CHAVE_CLUBE,
+    CHAVE_IDADE,
+    NUM_CHAVES
+} ChaveOrdenacao;
+
+// Nomes das chaves como aparecem no protocolo do servidor
+const char *nomesChaves[NUM_CHAVES] = {"nome", "posicao", "nacionalidade", "clube", "idade"};
+
+/**
+ * Função para converter o nome textual de uma chave no seu código
  * 
- * @param players Vetor ordenado
- * @param total Número total de jogadores
- * @param metodo Nome do método de ordenação usado
+ * @param nome Nome da chave (ex.: "clube")
+ * @return Código da chave, ou -1 se o nome for desconhecido
  */
-void salvarCSV(player *players, int total, const char *metodo) {
-    char filename[100];
-    snprintf(filename, sizeof(filename), "jogadores_ordenados_%s.csv", metodo);
-    
-    FILE *file = fopen(filename, "w");
-    if (file == NULL) {
-        printf("Erro ao criar arquivo %s\n", filename);
-        return;
+int chavePorNome(const char *nome) {
+    for (int i = 0; i < NUM_CHAVES; i++) {
+        if (strcmp(nome, nomesChaves[i]) == 0) {
+            return i;
+        }
     }
-    
-    // Escreve cabeçalho do CSV
-    fprintf(file, "Nome,Posição,Naturalidade,Clube,Idade\n");
-    
-    // Escreve dados dos jogadores
-    for (int i = 0; i < total; i++) {
-        fprintf(file, "%s,%s,%s,%s,%d\n", 
-                players[i].name, 
-                players[i].posicion, 
-                players[i].nationalite, 
-                players[i].team, 
-                players[i].age);
+    return -1;
+}
+
+/**
+ * Função que retorna o campo textual de um jogador correspondente à chave
+ * 
+ * @param p Jogador
+ * @param chave Chave de ordenação
+ * @return Ponteiro para o campo, ou NULL para chaves numéricas (idade)
+ */
+const char *campoTexto(const player *p, int chave) {
+    switch (chave) {
+        case CHAVE_NOME:          return p->name;
+        case CHAVE_POSICAO:       return p->posicion;
+        case CHAVE_NACIONALIDADE: return p->nationalite;
+        case CHAVE_CLUBE:         return p->team;
+        default:                  return NULL;
     }
-    
-    fclose(file);
-    printf("Arquivo salvo com sucesso: %s\n", filename);
 }
 
 /**
- * Função para exibir o menu principal
- * Interface textual para interação com o usuário
+ * Compara dois jogadores pela chave informada
+ * Não altera os contadores globais, podendo ser usada por várias threads
+ * 
+ * @return Retorna <0 se a < b, 0 se a == b, >0 se a > b
  */
-void exibirMenu() {
-    printf("\n=== MENU DE ORDENAÇÃO ===\n");
-    printf("1 - Ordenação Simples (Bubble Sort)\n");
-    printf("2 - Ordenação Ótima (Merge Sort)\n");
-    printf("3 - Ordenação Linear (Bucket Sort)\n");
-    printf("4 - Sair\n");
-    printf("Escolha uma opção: ");
+int compararPorChave(const player *a, const player *b, int chave) {
+    if (chave == CHAVE_IDADE) {
+        return (a->age > b->age) - (a->age < b->age);
+    }
+    return strcoll(campoTexto(a, chave), campoTexto(b, chave));
 }
 
 /**
- * Função principal que processa a ordenação selecionada
- * Coordena todo o processo: cópia, ordenação, exibição e salvamento
+ * Compara dois jogadores pelos bytes do nome (strcmp)
+ * Usada no índice de busca por prefixo, onde a ordem precisa ser binária
+ */
+int compararNomeBytes(const player *a, const player *b, int chave) {
+    (void)chave;
+    return strcmp(a->name, b->name);
+}
+
+typedef int (*ComparadorJogadores)(const player *a, const player *b, int chave);
+
+/**
+ * Ordena um vetor de índices (permutação) sem mover os jogadores
+ * Merge Sort bottom-up: O(n log n), estável
  * 
- * @param jogadores Vetor original de jogadores
- * @param total Número total de jogadores
- * @param opcao Opção de ordenação selecionada
+ * @param players Vetor de jogadores (apenas leitura)
+ * @param indices Vetor de índices a ser ordenado
+ * @param n Tamanho do vetor
+ * @param comparar Função de comparação
+ * @param chave Chave repassada à função de comparação
+ * @param direcao 1 para crescente, -1 para decrescente
+ * @return 1 em caso de sucesso, 0 se faltar memória
  */
-void processarOrdenacao(player *jogadores, int total, int opcao) {
-    char *nomeMetodo;
-    char *nomeDisplay;
-    clock_t inicio, fim;
-    Metricas metricas;
-    
-    // Cria cópia do vetor original para não modificar os dados originais
-    player *copia = (player*)malloc(total * sizeof(player));
-    if (copia == NULL) {
-        printf("Erro ao alocar memória para cópia\n");
-        return;
+int ordenarIndices(const player *players, int *indices, int n,
+                   ComparadorJogadores comparar, int chave, int direcao) {
+    TRACE_ESCOPO_ARG("ordenarIndices", "chave", chave);
+    int *aux = (int*)malloc(n * sizeof(int));
+    if (aux == NULL) {
+        return 0;
     }
-    memcpy(copia, jogadores, total * sizeof(player));
-    
-    printf("\nOrdenando...\n");
-    inicio = clock();  // Marca início do tempo
     
-    // Executa algoritmo selecionado
-    switch (opcao) {
-        case 1:
-            bubbleSort(copia, total, &metricas);
-            nomeMetodo = "bubble_sort";
-            nomeDisplay = "BUBBLE SORT";
-            break;
-        case 2:
-            mergeSort(copia, total, &metricas);
-            nomeMetodo = "merge_sort";
-            nomeDisplay = "MERGE SORT";
-            break;
-        case 3:
-            bucketSort(copia, total, &metricas);
-            nomeMetodo = "bucket_sort";
-            nomeDisplay = "BUCKET SORT";
-            break;
-        default:
-            free(copia);
-            return;
+    int *origem = indices, *destino = aux;
+    for (int largura = 1; largura < n; largura *= 2) {
+        for (int left = 0; left < n; left += 2 * largura) {
+            int mid = left + largura < n ? left + largura : n;
+            int right = left + 2 * largura < n ? left + 2 * largura : n;
+            int i = left, j = mid, k = left;
+            
+            // Empates ficam com o elemento da esquerda, preservando a estabilidade
+            while (i < mid && j < right) {
+                int c = comparar(&players[origem[i]], &players[origem[j]], chave) * direcao;
+                destino[k++] = (c <= 0) ? origem[i++] : origem[j++];
+            }
+            while (i < mid) destino[k++] = origem[i++];
+            while (j < right) destino[k++] = origem[j++];
+        }
+        int *t = origem; origem = destino; destino = t;
     }
     
-    fim = clock();  // Marca fim do tempo
-    metricas.tempo_execucao = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
-    
-    // Exibe resultados: primeiro o vetor ordenado, depois as métricas
-    imprimirTodosJogadores(copia, total);
-    exibirMetricas(metricas, nomeDisplay);
-    
-    // Oferece opção de salvar resultados
-    printf("Deseja salvar o vetor ordenado? (s/n): ");
-    char resposta;
-    scanf(" %c", &resposta);
-    
-    if (resposta == 's' || resposta == 'S') {
-        salvarCSV(copia, total, nomeMetodo);
-    } else {
-        printf("Arquivo não salvo.\n");
+    // Garante que o resultado final fique no vetor do chamador
+    if (origem != indices) {
+        memcpy(indices, origem, n * sizeof(int));
     }
-    
-    free(copia);  // Libera memória da cópia
+    free(aux);
+    return 1;
 }
 
 // ============================================================================
-// FUNÇÕES DE CARREGAMENTO DE DADOS
+// ORDENAÇÃO LINEAR POR CHAVES INTEIRAS
 // ============================================================================
 
 /**
- * Função para ler dados de jogadores a partir de arquivo CSV
- * 
- * @param filename Nome do arquivo CSV
- * @param total_players Ponteiro para variável que receberá o total de jogadores
- * @return Ponteiro para vetor alocado com os jogadores, ou NULL em caso de erro
+ * Assinatura comum dos algoritmos selecionáveis no menu
+ * Retorna 1 se o vetor foi ordenado, 0 em caso de falha (vetor inalterado)
  */
-player *lerCSV(const char *filename, int *total_players)
-{
-    FILE *file = fopen(filename, "r");
-    if (file == NULL)
-    {
-        printf("Erro ao abrir o arquivo %s\n", filename);
-        return NULL;
-    }
+typedef int (*AlgoritmoOrdenacao)(player *players, int n, Metricas *metricas);
 
-    int count = 0;
-    char linha[500];
+#define IDADE_MAXIMA 150  // Idades aceitas pelo Counting Sort: 0 a IDADE_MAXIMA
 
-    // Pula linha de cabeçalho
-    if (fgets(linha, sizeof(linha), file) == NULL) {
-        printf("Erro: arquivo vazio ou inválido\n");
-        fclose(file);
-        return NULL;
+/**
+ * 4. COUNTING SORT - Ordenação por contagem da idade
+ * Complexidade: O(n + k), k = faixa de idades
+ * Estável: Sim
+ * In-place: Não
+ * 
+ * @param players Vetor de jogadores
+ * @param n Tamanho do vetor
+ * @param metricas Ponteiro para métricas
+ * @return 1 em caso de sucesso, 0 se faltar memória ou houver idade fora de 0..IDADE_MAXIMA
+ */
+int countingSortIdade(player *players, int n, Metricas *metricas) {
+    TRACE_ESCOPO_ARG("countingSortIdade", "n", n);
+    comparacoes_count = 0;
+    trocas_count = 0;
+    metricas->passadas = 0;
+    metricas->memoria_gasta = n * sizeof(player) / 1024.0 / 1024.0;
+    if (n <= 1) {
+        metricas->comparacoes = 0;
+        metricas->trocas = 0;
+        return 1;
     }
-
-    // Conta número de linhas de dados
-    while (fgets(linha, sizeof(linha), file) != NULL) {
-        count++;
+    
+    // Passada 1: descobre a faixa de idades
+    int menor = players[0].age, maior = players[0].age;
+    for (int i = 1; i < n; i++) {
+        if (players[i].age < menor) menor = players[i].age;
+        if (players[i].age > maior) maior = players[i].age;
     }
     
-    if (count == 0) {
-        printf("Nenhum dado encontrado no arquivo\n");
-        fclose(file);
-        return NULL;
+    // Idades vêm de atoi sobre o CSV: valores absurdos gerariam uma tabela
+    // de contagem gigante (ou estouro no cálculo da faixa)
+    if (menor < 0 || maior > IDADE_MAXIMA) {
+        printf("Erro: idade %d fora da faixa aceita (0 a %d)\n", menor < 0 ? menor : maior, IDADE_MAXIMA);
+        return 0;
     }
+    int faixa = maior - menor + 1;
     
-    // Retorna ao início do arquivo para ler os dados
-    rewind(file);
+    int *contagem = (int*)calloc(faixa, sizeof(int));
+    player *saida = (player*)malloc(n * sizeof(player));
+    if (contagem == NULL || saida == NULL) {
+        printf("Erro ao alocar memória para o Counting Sort\n");
+        free(contagem);
+        free(saida);
+        return 0;
+    }
     
-    // Aloca memória para o vetor de jogadores
-    player* players = (player*)malloc(count * sizeof(player));
-    if (players == NULL) {
-        printf("Erro ao alocar memória\n");
-        fclose(file);
-        return NULL;
+    // Passada 2: conta as ocorrências de cada idade
+    for (int i = 0; i < n; i++) {
+        contagem[players[i].age - menor]++;
     }
     
-    // Pula cabeçalho novamente
-    fgets(linha, sizeof(linha), file);
+    // Soma de prefixos: contagem[k] passa a ser a primeira posição da idade k
+    int posicao = 0;
+    for (int k = 0; k < faixa; k++) {
+        int quantidade = contagem[k];
+        contagem[k] = posicao;
+        posicao += quantidade;
+    }
     
-    // Lê e processa cada linha de dados
-    int index = 0;
-    while (fgets(linha, sizeof(linha), file) != NULL && index < count) {
-        // Remove caracteres de nova linha
-        linha[strcspn(linha, "\n")] = 0;
-        linha[strcspn(linha, "\r")] = 0;
+    // Passada 3: distribui na ordem original, preservando a estabilidade
+    for (int i = 0; i < n; i++) {
+        saida[contagem[players[i].age - menor]++] = players[i];
+        trocas_count++;
+    }
+    
+    // Passada 4: copia o resultado de volta
+    memcpy(players, saida, n * sizeof(player));
+    trocas_count += n;
+    
+    free(contagem);
+    free(saida);
+    
+    metricas->comparacoes = comparacoes_count;
+    metricas->trocas = trocas_count;
+    metricas->passadas = 4;
+    metricas->memoria_gasta = (n * sizeof(player) * 2 + faixa * sizeof(int)) / 1024.0 / 1024.0;
+    return 1;
+}
 
-        char *token;
-        int campo = 0;
+/**
+ * Compara dois jogadores pela chave contando a comparação nas métricas
+ */
+int compararPorChaveContando(const player *a, const player *b, int chave) {
+    comparacoes_count++;
+    return compararPorChave(a, b, chave);
+}
 
-        // Cria cópia da linha para tokenização (strtok modifica a string original)
-        char linha_copia[500];
-        strcpy(linha_copia, linha);
-        
-        // Divide a linha em tokens separados por vírgula
-        token = strtok(linha_copia, ",");
-        while (token != NULL && campo < 5)
-        {
-            // Remove espaços em branco do início e fim do token
-            while (*token == ' ') token++;
+/**
+ * Codifica um campo textual por dicionário: cada valor distinto recebe sua
+ * posição na ordem do locale, de modo que comparar códigos equivale a
+ * comparar os textos
+ * 
+ * Os k valores distintos são encontrados com uma tabela hash (uma passada),
+ * apenas eles são ordenados (O(k log k)) e cada jogador recebe seu código
+ * numa última passada linear. As comparações de texto (sondagens da tabela
+ * e ordenação dos distintos) entram em comparacoes_count
+ * 
+ * @param players Vetor de jogadores
+ * @param n Tamanho do vetor
+ * @param chave Campo textual a ser codificado
+ * @param codigos Vetor de saída com o código de cada jogador
+ * @param metricas Ponteiro para métricas (acumula passadas e memória)
+ * @return Número de códigos distintos, ou -1 se faltar memória
+ */
+int codificarDicionario(const player *players, int n, int chave, unsigned int *codigos, Metricas *metricas) {
+    TRACE_ESCOPO_ARG("codificarDicionario", "chave", chave);
+    
+    // Tabela hash com endereçamento aberto, ao menos o dobro de n posições
+    int capacidade = 16;
+    while (capacidade < 2 * n) capacidade *= 2;
+    int *tabela = (int*)malloc(capacidade * sizeof(int));   // Índice em distintos (-1 = vazia)
+    int *distintos = (int*)malloc(n * sizeof(int));         // Um jogador representante por valor
+    unsigned int *codigoDistinto = (unsigned int*)malloc(n * sizeof(unsigned int));
+    if (tabela == NULL || distintos == NULL || codigoDistinto == NULL) {
+        free(tabela);
+        free(distintos);
+        free(codigoDistinto);
+        return -1;
+    }
+    memset(tabela, -1, capacidade * sizeof(int));
+    
+    // Passada 1: identifica os valores distintos; codigos recebe provisoriamente
+    // o número do valor distinto de cada jogador
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        const char *valor = campoTexto(&players[i], chave);
+        unsigned long long h = 1469598103934665603ULL;
+        for (const char *p = valor; *p; p++) {
+            h = (h ^ (unsigned char)*p) * 1099511628211ULL;
+        }
+        
+        int pos = (int)(h & (capacidade - 1));
+        while (tabela[pos] >= 0) {
+            comparacoes_count++;
+            if (strcmp(campoTexto(&players[distintos[tabela[pos]]], chave), valor) == 0) {
+                break;
+            }
+            pos = (pos + 1) & (capacidade - 1);
+        }
+        if (tabela[pos] < 0) {
+            tabela[pos] = k;
+            distintos[k++] = i;
+        }
+        codigos[i] = (unsigned int)tabela[pos];
+    }
+    
+    // Ordena apenas os k representantes
+    if (!ordenarIndices(players, distintos, k, compararPorChaveContando, chave, 1)) {
+        free(tabela);
+        free(distintos);
+        free(codigoDistinto);
+        return -1;
+    }
+    
+    // Cada novo valor na ordem crescente recebe o próximo código; textos
+    // diferentes que o locale considera iguais compartilham o código
+    unsigned int codigo = 0;
+    for (int j = 0; j < k; j++) {
+        if (j > 0 && compararPorChaveContando(&players[distintos[j - 1]], &players[distintos[j]], chave) != 0) {
+            codigo++;
+        }
+        codigoDistinto[codigos[distintos[j]]] = codigo;
+    }
+    
+    // Passada 2: troca o número do valor distinto pelo código ordenado
+    for (int i = 0; i < n; i++) {
+        codigos[i] = codigoDistinto[codigos[i]];
+    }
+    
+    free(tabela);
+    free(distintos);
+    free(codigoDistinto);
+    
+    metricas->passadas += 2;
+    metricas->memoria_gasta += (capacidade * sizeof(int) + n * (sizeof(int) + sizeof(unsigned int))) / 1024.0 / 1024.0;
+    return k > 0 ? (int)codigo + 1 : 0;
+}
+
+/**
+ * 5. RADIX SORT LSD - Ordenação por dígitos, do menos para o mais significativo
+ * Complexidade: O(d * (n + 256)), d = bytes da maior chave
+ * Estável: Sim
+ * In-place: Não
+ * 
+ * Ordena por chaves inteiras sem sinal em base 256. As chaves podem vir de um
+ * campo inteiro ou de um código de dicionário (codificarDicionario)
+ * 
+ * @param players Vetor de jogadores
+ * @param chaves Vetor paralelo de chaves, reordenado junto com os jogadores
+ * @param n Tamanho do vetor
+ * @param metricas Ponteiro para métricas (acumula trocas e passadas)
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int radixSortLSD(player *players, unsigned int *chaves, int n, Metricas *metricas) {
+    TRACE_ESCOPO_ARG("radixSortLSD", "n", n);
+    
+    // Passada inicial: a maior chave define quantos dígitos processar
+    unsigned int maior = 0;
+    for (int i = 0; i < n; i++) {
+        if (chaves[i] > maior) maior = chaves[i];
+    }
+    metricas->passadas++;
+    
+    player *auxPlayers = (player*)malloc(n * sizeof(player));
+    unsigned int *auxChaves = (unsigned int*)malloc(n * sizeof(unsigned int));
+    if (auxPlayers == NULL || auxChaves == NULL) {
+        free(auxPlayers);
+        free(auxChaves);
+        return 0;
+    }
+    
+    player *origemP = players, *destinoP = auxPlayers;
+    unsigned int *origemC = chaves, *destinoC = auxChaves;
+    
+    for (int deslocamento = 0; deslocamento < 32 && (maior >> deslocamento) > 0; deslocamento += 8) {
+        TRACE_ESCOPO_ARG("radixSortLSD.digito", "deslocamento", deslocamento);
+        int contagem[256] = {0};
+        
+        // Conta cada valor do dígito atual
+        for (int i = 0; i < n; i++) {
+            contagem[(origemC[i] >> deslocamento) & 0xFF]++;
+        }
+        
+        int posicao = 0;
+        for (int d = 0; d < 256; d++) {
+            int quantidade = contagem[d];
+            contagem[d] = posicao;
+            posicao += quantidade;
+        }
+        
+        // Distribui de forma estável pelo dígito
+        for (int i = 0; i < n; i++) {
+            int destino = contagem[(origemC[i] >> deslocamento) & 0xFF]++;
+            destinoP[destino] = origemP[i];
+            destinoC[destino] = origemC[i];
+            trocas_count++;
+        }
+        metricas->passadas += 2;
+        
+        player *tp = origemP; origemP = destinoP; destinoP = tp;
+        unsigned int *tc = origemC; origemC = destinoC; destinoC = tc;
+    }
+    
+    // Número ímpar de dígitos: o resultado está no buffer auxiliar
+    if (origemP != players) {
+        memcpy(players, origemP, n * sizeof(player));
+        memcpy(chaves, origemC, n * sizeof(unsigned int));
+        trocas_count += n;
+        metricas->passadas++;
+    }
+    
+    free(auxPlayers);
+    free(auxChaves);
+    metricas->memoria_gasta += (n * (sizeof(player) + sizeof(unsigned int)) + 256 * sizeof(int)) / 1024.0 / 1024.0;
+    return 1;
+}
+
+/**
+ * Radix Sort LSD aplicado a um campo do jogador
+ * Idade é usada diretamente (deslocada pela menor idade); campos textuais
+ * são antes codificados por dicionário
+ * 
+ * @param players Vetor de jogadores
+ * @param n Tamanho do vetor
+ * @param chave Campo a ordenar
+ * @param metricas Ponteiro para métricas
+ * @return 1 em caso de sucesso, 0 se faltar memória
+ */
+int radixSortCampo(player *players, int n, int chave, Metricas *metricas) {
+    comparacoes_count = 0;
+    trocas_count = 0;
+    metricas->passadas = 0;
+    metricas->memoria_gasta = (n * (sizeof(player) + sizeof(unsigned int))) / 1024.0 / 1024.0;
+    
+    unsigned int *chaves = (unsigned int*)malloc(n * sizeof(unsigned int));
+    if (chaves == NULL) {
+        printf("Erro ao alocar memória para o Radix Sort\n");
+        return 0;
+    }
+    
+    if (chave == CHAVE_IDADE) {
+        int menor = n > 0 ? players[0].age : 0;
+        for (int i = 1; i < n; i++) {
+            if (players[i].age < menor) menor = players[i].age;
+        }
+        for (int i = 0; i < n; i++) {
+            // Em long long a diferença não estoura e sempre cabe em 32 bits
+            chaves[i] = (unsigned int)((long long)players[i].age - menor);
+        }
+        metricas->passadas += 2;
+    } else {
+        if (codificarDicionario(players, n, chave, chaves, metricas) < 0) {
+            printf("Erro ao alocar memória para o dicionário\n");
+            free(chaves);
+            return 0;
+        }
+    }
+    
+    int ok = radixSortLSD(players, chaves, n, metricas);
+    if (!ok) {
+        printf("Erro ao alocar memória para o Radix Sort\n");
+    }
+    free(chaves);
+    
+    metricas->comparacoes = comparacoes_count;
+    metricas->trocas = trocas_count;
+    return ok;
+}
+
+/**
+ * Radix Sort LSD pelo clube (campo textual codificado por dicionário)
+ */
+int radixSortClube(player *players, int n, Metricas *metricas) {
+    return radixSortCampo(players, n, CHAVE_CLUBE, metricas);
+}
+
+/**
+ * Ordenação por múltiplos campos
+ * Executa primeiro a ordenação pelo critério secundário e depois o critério
+ * principal como última passada estável: os empates do critério principal
+ * mantêm a ordem do secundário
+ * 
+ * @param players Vetor de jogadores
+ * @param n Tamanho do vetor
+ * @param secundaria Ordenação pelo critério de desempate (ex.: Merge Sort por nome)
+ * @param ultima Ordenação estável pelo critério principal (ex.: Counting Sort por idade)
+ * @param metricas Ponteiro para métricas (soma das duas etapas)
+ * @return 1 se as duas etapas concluíram, 0 caso contrário
+ */
+int ordenarMultiCampo(player *players, int n, AlgoritmoOrdenacao secundaria,
+                       AlgoritmoOrdenacao ultima, Metricas *metricas) {
+    Metricas primeira = *metricas;
+    
+    if (!secundaria(players, n, &primeira) || !ultima(players, n, metricas)) {
+        return 0;
+    }
+    
+    metricas->comparacoes += primeira.comparacoes;
+    metricas->trocas += primeira.trocas;
+    metricas->passadas += primeira.passadas;
+    if (primeira.memoria_gasta > metricas->memoria_gasta) {
+        metricas->memoria_gasta = primeira.memoria_gasta;  // As etapas não coexistem na memória
+    }
+    return 1;
+}
+
+/**
+ * Idade, depois nome: Merge Sort por nome seguido de Counting Sort por idade
+ */
+int ordenarIdadeDepoisNome(player *players, int n, Metricas *metricas) {
+    return ordenarMultiCampo(players, n, mergeSort, countingSortIdade, metricas);
+}
+
+/**
+ * Clube, depois nome: Merge Sort por nome seguido de Radix Sort por clube
+ */
+int ordenarClubeDepoisNome(player *players, int n, Metricas *metricas) {
+    return ordenarMultiCampo(players, n, mergeSort, radixSortClube, metricas);
+}
+
+// ============================================================================
+// CACHE DE ORDENAÇÕES
+// ============================================================================
+
+/*
+ * Os jogadores não mudam depois de carregados, então a permutação resultante
+ * de uma ordenação pode ser reaproveitada. As entradas são indexadas por
+ * (chave, direção, família): Bubble Sort, Merge Sort e ordenarIndices fazem a
+ * mesma comparação estável e produzem a mesma ordem, compartilhando a família
+ * ORDEM_COMPARACAO; o Bucket Sort agrupa pela inicial normalizada e pode
+ * divergir (nomes acentuados), por isso tem família própria.
+ */
+
+typedef enum {
+    ORDEM_COMPARACAO = 0,    // Bubble Sort, Merge Sort e ordenarIndices
+    ORDEM_BUCKETS,           // Bucket Sort
+    NUM_FAMILIAS_ORDEM
+} FamiliaOrdem;
+
+#define MAGICO_CACHE "JOGCACHE2"
+#define TAM_NOME_COLACAO 64      // Nome do LC_COLLATE gravado no cabeçalho do cache
+
+typedef struct {
+    unsigned long long assinatura;  // Hash dos dados que geraram as permutações
+    int total;
+    int *ordens[NUM_CHAVES][2][NUM_FAMILIAS_ORDEM];  // NULL enquanto não calculada
+    long long acertos;              // Consultas atendidas pelo cache
+    long long falhas;               // Consultas que exigiram ordenar
+    bool modificado;                // Há entradas ainda não gravadas em disco
+} CacheOrdenacao;
+
+CacheOrdenacao cache = {0};
+
+/**
+ * Calcula uma assinatura (FNV-1a de 64 bits) do conteúdo dos jogadores
+ * Considera apenas os bytes úteis de cada campo, ignorando lixo após o '\0'
+ */
+unsigned long long assinaturaJogadores(const player *players, int n) {
+    unsigned long long h = 1469598103934665603ULL;
+    for (int i = 0; i < n; i++) {
+        const char *campos[4] = {players[i].name, players[i].posicion,
+                                 players[i].nationalite, players[i].team};
+        for (int c = 0; c < 4; c++) {
+            for (const char *p = campos[c]; ; p++) {
+                h = (h ^ (unsigned char)*p) * 1099511628211ULL;  // Inclui o '\0' como separador
+                if (*p == '\0') break;
+            }
+        }
+        h = (h ^ (unsigned int)players[i].age) * 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * Descarta todas as entradas do cache
+ */
+void cacheInvalidar() {
+    for (int c = 0; c < NUM_CHAVES; c++) {
+        for (int d = 0; d < 2; d++) {
+            for (int f = 0; f < NUM_FAMILIAS_ORDEM; f++) {
+                free(cache.ordens[c][d][f]);
+                cache.ordens[c][d][f] = NULL;
+            }
+        }
+    }
+    cache.modificado = false;
+}
+
+/**
+ * Associa o cache aos dados carregados
+ * Deve ser chamada sempre que o vetor de jogadores mudar; se o conteúdo
+ * for diferente do que gerou as entradas atuais, o cache é invalidado
+ */
+void cacheVincular(const player *players, int n) {
+    unsigned long long assinatura = assinaturaJogadores(players, n);
+    if (assinatura != cache.assinatura || n != cache.total) {
+        cacheInvalidar();
+        cache.assinatura = assinatura;
+        cache.total = n;
+    }
+}
+
+/**
+ * Busca uma permutação no cache, atualizando os contadores
+ * 
+ * @return Permutação (pertence ao cache), ou NULL se ainda não calculada
+ */
+const int *cacheBuscar(int chave, int direcao, int familia) {
+    const int *ordem = cache.ordens[chave][direcao][familia];
+    if (ordem != NULL) {
+        cache.acertos++;
+    } else {
+        cache.falhas++;
+    }
+    return ordem;
+}
+
+/**
+ * Guarda uma cópia da permutação no cache
+ */
+void cacheGuardar(int chave, int direcao, int familia, const int *ordem) {
+    int *copia = (int*)malloc(cache.total * sizeof(int));
+    if (copia == NULL) {
+        return;  // Sem memória: apenas deixa de armazenar
+    }
+    memcpy(copia, ordem, cache.total * sizeof(int));
+    free(cache.ordens[chave][direcao][familia]);
+    cache.ordens[chave][direcao][familia] = copia;
+    cache.modificado = true;
+}
+
+/**
+ * Verifica se o vetor é uma permutação de [0, n): cada índice no intervalo
+ * e presente exatamente uma vez
+ * 
+ * @param visto Vetor auxiliar com n posições (sobrescrito)
+ */
+bool permutacaoValida(const int *ordem, int n, unsigned char *visto) {
+    memset(visto, 0, n);
+    for (int i = 0; i < n; i++) {
+        if (ordem[i] < 0 || ordem[i] >= n || visto[ordem[i]]) {
+            return false;
+        }
+        visto[ordem[i]] = 1;
+    }
+    return true;
+}
+
+/**
+ * Carrega o cache de um arquivo gravado por cacheSalvar
+ * Entradas de outro conteúdo (assinatura diferente) são ignoradas, assim
+ * como entradas corrompidas que não sejam permutações válidas;
+ * cacheVincular deve ter sido chamada antes
+ * 
+ * @param filename Nome do arquivo de cache
+ * @return Número de permutações carregadas
+ */
+int cacheCarregar(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    
+    char magico[sizeof(MAGICO_CACHE)];
+    unsigned long long assinatura;
+    int total;
+    char colacao[TAM_NOME_COLACAO];
+    char colacaoAtual[TAM_NOME_COLACAO] = {0};
+    strncpy(colacaoAtual, setlocale(LC_COLLATE, NULL), sizeof(colacaoAtual) - 1);
+    
+    // As ordens por texto dependem do strcoll: um cache gerado com outro
+    // LC_COLLATE (ex.: pt_BR.UTF-8 indisponível, caindo para "C") é descartado
+    if (fread(magico, sizeof(magico), 1, file) != 1 || memcmp(magico, MAGICO_CACHE, sizeof(magico)) != 0 ||
+        fread(&assinatura, sizeof(assinatura), 1, file) != 1 || fread(&total, sizeof(total), 1, file) != 1 ||
+        fread(colacao, sizeof(colacao), 1, file) != 1 ||
+        assinatura != cache.assinatura || total != cache.total ||
+        memcmp(colacao, colacaoAtual, sizeof(colacao)) != 0) {
+        fclose(file);
+        return 0;
+    }
+    
+    int carregadas = 0;
+    unsigned char slot[3];
+    int *ordem = (int*)malloc(total * sizeof(int));
+    unsigned char *visto = (unsigned char*)malloc(total);
+    while (ordem != NULL && visto != NULL && fread(slot, sizeof(slot), 1, file) == 1 &&
+           fread(ordem, sizeof(int), total, file) == (size_t)total) {
+        if (slot[0] >= NUM_CHAVES || slot[1] >= 2 || slot[2] >= NUM_FAMILIAS_ORDEM) {
+            break;
+        }
+        if (!permutacaoValida(ordem, total, visto)) {
+            continue;  // Entrada corrompida: descarta e segue para a próxima
+        }
+        cacheGuardar(slot[0], slot[1], slot[2], ordem);
+        carregadas++;
+    }
+    
+    free(ordem);
+    free(visto);
+    fclose(file);
+    cache.modificado = false;
+    return carregadas;
+}
+
+/**
+ * Grava as permutações do cache em arquivo, se houver novidades
+ * 
+ * @param filename Nome do arquivo de cache
+ */
+void cacheSalvar(const char *filename) {
+    if (!cache.modificado) {
+        return;
+    }
+    
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("Erro ao criar arquivo %s\n", filename);
+        return;
+    }
+    
+    fwrite(MAGICO_CACHE, sizeof(MAGICO_CACHE), 1, file);
+    fwrite(&cache.assinatura, sizeof(cache.assinatura), 1, file);
+    fwrite(&cache.total, sizeof(cache.total), 1, file);
+    char colacao[TAM_NOME_COLACAO] = {0};
+    strncpy(colacao, setlocale(LC_COLLATE, NULL), sizeof(colacao) - 1);
+    fwrite(colacao, sizeof(colacao), 1, file);
+    for (int c = 0; c < NUM_CHAVES; c++) {
+        for (int d = 0; d < 2; d++) {
+            for (int f = 0; f < NUM_FAMILIAS_ORDEM; f++) {
+                if (cache.ordens[c][d][f] != NULL) {
+                    unsigned char slot[3] = {c, d, f};
+                    fwrite(slot, sizeof(slot), 1, file);
+                    fwrite(cache.ordens[c][d][f], sizeof(int), cache.total, file);
+                }
+            }
+        }
+    }
+    
+    fclose(file);
+    cache.modificado = false;
+    printf("Cache salvo com sucesso: %s\n", filename);
+}
+
+// ============================================================================
+// FUNÇÕES DE ARQUIVO E INTERFACE
+// ============================================================================
+
+/**
+ * Função para salvar o vetor ordenado em arquivo CSV
+ * 
+ * @param players Vetor ordenado
+ * @param total Número total de jogadores
+ * @param metodo Nome do método de ordenação usado
+ */
+void salvarCSV(player *players, int total, const char *metodo) {
+    char filename[100];
+    TRACE_ESCOPO("salvarCSV");
+    snprintf(filename, sizeof(filename), "jogadores_ordenados_%s.csv", metodo);
+    
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        printf("Erro ao criar arquivo %s\n", filename);
+        return;
+    }
+    
+    // Escreve cabeçalho do CSV
+    fprintf(file, "Nome,Posição,Naturalidade,Clube,Idade\n");
+    
+    // Escreve dados dos jogadores
+    for (int i = 0; i < total; i++) {
+        fprintf(file, "%s,%s,%s,%s,%d\n", 
+                players[i].name, 
+                players[i].posicion, 
+                players[i].nationalite, 
+                players[i].team, 
+                players[i].age);
+    }
+    
+    fclose(file);
+    printf("Arquivo salvo com sucesso: %s\n", filename);
+}
+
+/**
+ * Função para exibir o menu principal
+ * Interface textual para interação com o usuário
+ */
+void exibirMenu() {
+    printf("\n=== MENU DE ORDENAÇÃO ===\n");
+    printf("1 - Ordenação Simples (Bubble Sort)\n");
+    printf("2 - Ordenação Ótima (Merge Sort)\n");
+    printf("3 - Ordenação Linear (Bucket Sort)\n");
+    printf("4 - Ordenação por Idade (Counting Sort)\n");
+    printf("5 - Ordenação por Clube (Radix Sort LSD)\n");
+    printf("6 - Idade, depois Nome (Merge Sort + Counting Sort)\n");
+    printf("7 - Clube, depois Nome (Merge Sort + Radix Sort LSD)\n");
+    printf("0 - Sair\n");
+    printf("Escolha uma opção: ");
+}
+
+/**
+ * Função principal que processa a ordenação selecionada
+ * Coordena todo o processo: cópia, ordenação, exibição e salvamento
+ * 
+ * @param jogadores Vetor original de jogadores
+ * @param total Número total de jogadores
+ * @param opcao Opção de ordenação selecionada
+ */
+void processarOrdenacao(player *jogadores, int total, int opcao) {
+    char *nomeMetodo;
+    char *nomeDisplay;
+    clock_t inicio, fim;
+    Metricas metricas = {0};
+    AlgoritmoOrdenacao algoritmo;
+    int chave = CHAVE_NOME;   // Chave no cache (-1 para ordenações por vários campos)
+    int familia = ORDEM_COMPARACAO;
+    
+    switch (opcao) {
+        case 1:
+            algoritmo = bubbleSort;
+            nomeMetodo = "bubble_sort";
+            nomeDisplay = "BUBBLE SORT";
+            break;
+        case 2:
+            algoritmo = mergeSort;
+            nomeMetodo = "merge_sort";
+            nomeDisplay = "MERGE SORT";
+            break;
+        case 3:
+            algoritmo = bucketSort;
+            nomeMetodo = "bucket_sort";
+            nomeDisplay = "BUCKET SORT";
+            familia = ORDEM_BUCKETS;
+            break;
+        case 4:
+            algoritmo = countingSortIdade;
+            nomeMetodo = "counting_sort_idade";
+            nomeDisplay = "COUNTING SORT";
+            chave = CHAVE_IDADE;
+            break;
+        case 5:
+            algoritmo = radixSortClube;
+            nomeMetodo = "radix_sort_clube";
+            nomeDisplay = "RADIX SORT LSD";
+            chave = CHAVE_CLUBE;
+            break;
+        case 6:
+            algoritmo = ordenarIdadeDepoisNome;
+            nomeMetodo = "idade_nome";
+            nomeDisplay = "MERGE SORT + COUNTING SORT";
+            chave = -1;
+            break;
+        case 7:
+            algoritmo = ordenarClubeDepoisNome;
+            nomeMetodo = "clube_nome";
+            nomeDisplay = "MERGE SORT + RADIX SORT LSD";
+            chave = -1;
+            break;
+        default:
+            return;
+    }
+    
+    // Cria cópia do vetor original para não modificar os dados originais
+    player *copia = (player*)malloc(total * sizeof(player));
+    if (copia == NULL) {
+        printf("Erro ao alocar memória para cópia\n");
+        return;
+    }
+    
+    // O trace da ordenação termina antes da pergunta de salvamento,
+    // para não incluir o tempo de resposta do usuário
+    {
+        TRACE_ESCOPO("processarOrdenacao");
+        
+        const int *ordem = chave >= 0 ? cacheBuscar(chave, 0, familia) : NULL;
+        
+        if (ordem != NULL) {
+            printf("\nOrdenação encontrada no cache...\n");
+            inicio = clock();
+            
+            // Monta o vetor ordenado aplicando a permutação guardada: O(n), sem comparações
+            for (int i = 0; i < total; i++) {
+                copia[i] = jogadores[ordem[i]];
+            }
+            
+            fim = clock();
+            metricas.do_cache = true;
+            metricas.trocas = total;
+            metricas.memoria_gasta = total * (sizeof(player) + sizeof(int)) / 1024.0 / 1024.0;
+        } else {
+            memcpy(copia, jogadores, total * sizeof(player));
+            
+            printf("\nOrdenando...\n");
+            inicio = clock();  // Marca início do tempo
+            
+            // Executa algoritmo selecionado
+            if (!algoritmo(copia, total, &metricas)) {
+                // Vetor possivelmente fora de ordem: não exibe nem guarda no cache
+                printf("Erro: a ordenação %s não pôde ser concluída.\n", nomeDisplay);
+                free(copia);
+                return;
+            }
+            
+            fim = clock();  // Marca fim do tempo
+            
+            // Guarda a permutação resultante no cache (o id de cada cópia
+            // é a sua posição no vetor original)
+            int *permutacao = chave >= 0 ? (int*)malloc(total * sizeof(int)) : NULL;
+            if (permutacao != NULL) {
+                for (int i = 0; i < total; i++) {
+                    permutacao[i] = copia[i].id;
+                }
+                cacheGuardar(chave, 0, familia, permutacao);
+                free(permutacao);
+            }
+        }
+        
+        metricas.tempo_execucao = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+        metricas.acertos_cache = cache.acertos;
+        metricas.falhas_cache = cache.falhas;
+        
+        // Exibe resultados: primeiro o vetor ordenado, depois as métricas
+        imprimirTodosJogadores(copia, total);
+        exibirMetricas(metricas, nomeDisplay);
+    }
+    
+    // Oferece opção de salvar resultados
+    printf("Deseja salvar o vetor ordenado? (s/n): ");
+    char resposta;
+    scanf(" %c", &resposta);
+    
+    if (resposta == 's' || resposta == 'S') {
+        salvarCSV(copia, total, nomeMetodo);
+    } else {
+        printf("Arquivo não salvo.\n");
+    }
+    
+    free(copia);  // Libera memória da cópia
+}
+
+// ============================================================================
+// FUNÇÕES DE CARREGAMENTO DE DADOS
+// ============================================================================
+
+/**
+ * Função para ler dados de jogadores a partir de arquivo CSV
+ * 
+ * @param filename Nome do arquivo CSV
+ * @param total_players Ponteiro para variável que receberá o total de jogadores
+ * @return Ponteiro para vetor alocado com os jogadores, ou NULL em caso de erro
+ */
+player *lerCSV(const char *filename, int *total_players)
+{
+    TRACE_ESCOPO("lerCSV");
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        printf("Erro ao abrir o arquivo %s\n", filename);
+        return NULL;
+    }
+
+    int count = 0;
+    char linha[500];
+
+    // Pula linha de cabeçalho
+    if (fgets(linha, sizeof(linha), file) == NULL) {
+        printf("Erro: arquivo vazio ou inválido\n");
+        fclose(file);
+        return NULL;
+    }
+
+    // Conta número de linhas de dados
+    while (fgets(linha, sizeof(linha), file) != NULL) {
+        count++;
+    }
+    
+    if (count == 0) {
+        printf("Nenhum dado encontrado no arquivo\n");
+        fclose(file);
+        return NULL;
+    }
+    
+    // Retorna ao início do arquivo para ler os dados
+    rewind(file);
+    
+    // Aloca memória para o vetor de jogadores
+    player* players = (player*)malloc(count * sizeof(player));
+    if (players == NULL) {
+        printf("Erro ao alocar memória\n");
+        fclose(file);
+        return NULL;
+    }
+    
+    // Pula cabeçalho novamente
+    fgets(linha, sizeof(linha), file);
+    
+    // Lê e processa cada linha de dados
+    int index = 0;
+    while (fgets(linha, sizeof(linha), file) != NULL && index < count) {
+        // Remove caracteres de nova linha
+        linha[strcspn(linha, "\n")] = 0;
+        linha[strcspn(linha, "\r")] = 0;
+
+        char *token;
+        int campo = 0;
+
+        // Cria cópia da linha para tokenização (strtok modifica a string original)
+        char linha_copia[500];
+        strcpy(linha_copia, linha);
+        
+        // Divide a linha em tokens separados por vírgula
+        token = strtok(linha_copia, ",");
+        while (token != NULL && campo < 5)
+        {
+            // Remove espaços em branco do início e fim do token
+            while (*token == ' ') token++;
             char *end = token + strlen(token) - 1;
             while (end > token && *end == ' ') end--;
             *(end + 1) = '\0';
 
-            // Distribui tokens nos campos correspondentes da estrutura
-            switch (campo)
-            {
-            case 0: // Nome
-                strncpy(players[index].name, token, sizeof(players[index].name) - 1);
-                players[index].name[sizeof(players[index].name) - 1] = '\0';
-                break;
-            case 1: // Posição
-                strncpy(players[index].posicion, token, sizeof(players[index].posicion) - 1);
-                players[index].posicion[sizeof(players[index].posicion) - 1] = '\0';
-                break;
-            case 2: // Naturalidade
-                strncpy(players[index].nationalite, token, sizeof(players[index].nationalite) - 1);
-                players[index].nationalite[sizeof(players[index].nationalite) - 1] = '\0';
-                break;
-            case 3: // Clube
-                strncpy(players[index].team, token, sizeof(players[index].team) - 1);
-                players[index].team[sizeof(players[index].team) - 1] = '\0';
-                break;
-            case 4: // Idade
-                players[index].age = atoi(token);  // Converte string para inteiro
-                break;
+            // Distribui tokens nos campos correspondentes da estrutura
+            switch (campo)
+            {
+            case 0: // Nome
+                strncpy(players[index].name, token, sizeof(players[index].name) - 1);
+                players[index].name[sizeof(players[index].name) - 1] = '\0';
+                break;
+            case 1: // Posição
+                strncpy(players[index].posicion, token, sizeof(players[index].posicion) - 1);
+                players[index].posicion[sizeof(players[index].posicion) - 1] = '\0';
+                break;
+            case 2: // Naturalidade
+                strncpy(players[index].nationalite, token, sizeof(players[index].nationalite) - 1);
+                players[index].nationalite[sizeof(players[index].nationalite) - 1] = '\0';
+                break;
+            case 3: // Clube
+                strncpy(players[index].team, token, sizeof(players[index].team) - 1);
+                players[index].team[sizeof(players[index].team) - 1] = '\0';
+                break;
+            case 4: // Idade
+                players[index].age = atoi(token);  // Converte string para inteiro
+                break;
+            }
+            campo++;
+            token = strtok(NULL, ",");
+        }
+
+        players[index].id = index;
+        players[index].prox = NULL;
+        index++;
+    }
+    
+    *total_players = count;
+    fclose(file);
+    return players;
+}
+
+/**
+ * Função para liberar memória alocada para o vetor de jogadores
+ * 
+ * @param players Ponteiro para o vetor a ser liberado
+ */
+void liberarPlayers(player *players) {
+    free(players);
+}
+
+/**
+ * Função para verificar se um arquivo existe
+ * 
+ * @param filename Nome do arquivo
+ * @return 1 se existe, 0 se não existe
+ */
+int arquivoExiste(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (file) {
+        fclose(file);
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// MODO SERVIDOR (SOCKET UNIX)
+// ============================================================================
+
+/*
+ * Protocolo de linhas (uma requisição por linha, respostas "OK <n>" seguidas
+ * de n linhas, ou "ERRO <mensagem>"):
+ *   ORDENAR <chave> [asc|desc]       vetor completo ordenado
+ *   TOP <chave> <k> [asc|desc]       apenas os k primeiros
+ *   PREFIXO <texto>                  jogadores cujo nome começa com o texto
+ *   AGRUPAR <chave>                  "valor,quantidade" para cada valor distinto
+ *   ESTATISTICAS                     percentis de latência (serviço e ponta a ponta)
+ *   SAIR                             encerra a conexão
+ * Chaves: nome, posicao, nacionalidade, clube, idade
+ */
+
+#define SOCKET_PADRAO "/tmp/jogadores.sock"
+#define TRABALHADORES_PADRAO 4    // Threads do pool quando não informado
+#define MAX_TRABALHADORES 64      // Limite aceito na linha de comando
+#define MAX_CONEXOES 256          // Conexões simultâneas; as excedentes são recusadas
+#define AMOSTRAS_LATENCIA 4096    // Janela de amostras para os percentis
+#define TAM_BUFFER_LEITURA 8192   // Maior lote de requisições lido de uma vez
+#define LIMITE_RESPOSTA_LOTE (1 << 20)  // Bytes acumulados antes de enviar parte do lote
+#define TEMPO_ESCRITA_S 30        // Cliente que não lê as respostas por este tempo é desconectado
+
+/**
+ * Dados mantidos em memória enquanto o servidor estiver ativo
+ * Após a carga são apenas lidos, dispensando travas nas consultas
+ */
+typedef struct {
+    player *jogadores;
+    int total;
+    int *ordens[NUM_CHAVES][2];   // Permutações pré-calculadas [chave][0 = asc, 1 = desc]
+    int *ordemPrefixo;            // Nomes em ordem binária para busca por prefixo
+} BaseResidente;
+
+/**
+ * Janela circular com as latências mais recentes (em microssegundos)
+ */
+typedef struct {
+    double amostras[AMOSTRAS_LATENCIA];
+    long long requisicoes;        // Total de requisições medidas
+} JanelaLatencia;
+
+/**
+ * Latências medidas de duas formas:
+ * - servico: apenas a execução do comando
+ * - pontaAPonta: da leitura do lote até a resposta ser escrita no socket,
+ *   incluindo a espera na fila por um trabalhador
+ */
+typedef struct {
+    pthread_mutex_t trava;
+    JanelaLatencia servico;
+    JanelaLatencia pontaAPonta;
+} EstatisticasLatencia;
+
+/**
+ * Estado de uma conexão aberta
+ * A thread principal lê do socket apenas enquanto a conexão não está com um
+ * trabalhador, de modo que as respostas saem na ordem das requisições
+ */
+typedef struct {
+    int fd;
+    char buffer[TAM_BUFFER_LEITURA];
+    size_t usado;                 // Bytes recebidos ainda não processados
+    double recebido;              // Instante em que o lote atual ficou completo
+    bool emAtendimento;           // Lote entregue a um trabalhador (protegido por fila.trava)
+    bool encerrar;                // Fechar assim que voltar à thread principal
+} Conexao;
+
+/**
+ * Fila circular de conexões com requisições completas aguardando um trabalhador
+ * Cada conexão está na fila no máximo uma vez, portanto ela nunca enche
+ */
+typedef struct {
+    Conexao *lotes[MAX_CONEXOES];
+    int inicio;
+    int tamanho;
+    bool encerrando;
+    pthread_mutex_t trava;
+    pthread_cond_t naoVazia;
+} FilaLotes;
+
+/**
+ * Buffer crescente onde as respostas de um lote são acumuladas
+ */
+typedef struct {
+    char *dados;
+    size_t tamanho;
+    size_t capacidade;
+    bool semMemoria;              // Alguma escrita não coube (resposta incompleta)
+} Resposta;
+
+BaseResidente base;
+EstatisticasLatencia latencias = {PTHREAD_MUTEX_INITIALIZER, {{0}, 0}, {{0}, 0}};
+FilaLotes fila = {{0}, 0, 0, false, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+Conexao *conexoes[MAX_CONEXOES];  // Conexões abertas (NULL = posição livre), só a thread principal altera
+volatile sig_atomic_t servidorAtivo = 1;
+int pipeSinal[2] = {-1, -1};      // Self-pipe: o tratador de sinal acorda o poll() do laço principal
+int pipeRetorno[2] = {-1, -1};    // Trabalhadores avisam a thread principal ao devolver uma conexão
+
+/**
+ * Acrescenta texto formatado (estilo printf) ao final da resposta
+ * 
+ * @return 1 em caso de sucesso, 0 se faltar memória (marca r->semMemoria)
+ */
+int respostaPrintf(Resposta *r, const char *formato, ...) {
+    va_list args;
+    for (;;) {
+        size_t livre = r->capacidade - r->tamanho;
+        va_start(args, formato);
+        int escrito = vsnprintf(r->dados ? r->dados + r->tamanho : NULL, livre, formato, args);
+        va_end(args);
+        if (escrito < 0) {
+            r->semMemoria = true;
+            return 0;
+        }
+        if ((size_t)escrito < livre) {
+            r->tamanho += escrito;
+            return 1;
+        }
+        // Não coube: dobra a capacidade e tenta de novo
+        size_t novaCapacidade = r->capacidade ? r->capacidade * 2 : 4096;
+        while (novaCapacidade - r->tamanho <= (size_t)escrito) {
+            novaCapacidade *= 2;
+        }
+        char *novo = (char*)realloc(r->dados, novaCapacidade);
+        if (novo == NULL) {
+            r->semMemoria = true;
+            return 0;
+        }
+        r->dados = novo;
+        r->capacidade = novaCapacidade;
+    }
+}
+
+/**
+ * Escreve um jogador na resposta no mesmo formato do CSV de saída
+ */
+void respostaJogador(Resposta *r, const player *p) {
+    respostaPrintf(r, "%s,%s,%s,%s,%d\n", p->name, p->posicion, p->nationalite, p->team, p->age);
+}
+
+/**
+ * Registra a mesma latência para várias requisições na janela circular
+ * 
+ * @param janela Janela de serviço ou de ponta a ponta
+ * @param micros Latência em microssegundos
+ * @param quantidade Número de requisições que tiveram essa latência
+ */
+void registrarLatencia(JanelaLatencia *janela, double micros, int quantidade) {
+    pthread_mutex_lock(&latencias.trava);
+    for (int i = 0; i < quantidade; i++) {
+        janela->amostras[janela->requisicoes % AMOSTRAS_LATENCIA] = micros;
+        janela->requisicoes++;
+    }
+    pthread_mutex_unlock(&latencias.trava);
+}
+
+int compararDoubles(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Escreve uma linha com os percentis de uma janela de latência
+ */
+void respostaPercentis(Resposta *r, const char *rotulo, const JanelaLatencia *janela) {
+    double copia[AMOSTRAS_LATENCIA];
+    
+    pthread_mutex_lock(&latencias.trava);
+    long long requisicoes = janela->requisicoes;
+    int n = requisicoes < AMOSTRAS_LATENCIA ? (int)requisicoes : AMOSTRAS_LATENCIA;
+    memcpy(copia, janela->amostras, n * sizeof(double));
+    pthread_mutex_unlock(&latencias.trava);
+    
+    if (n == 0) {
+        respostaPrintf(r, "%s requisicoes=0\n", rotulo);
+        return;
+    }
+    qsort(copia, n, sizeof(double), compararDoubles);
+    respostaPrintf(r, "%s requisicoes=%lld amostras=%d p50=%.1fus p90=%.1fus p99=%.1fus max=%.1fus\n",
+                   rotulo, requisicoes, n,
+                   copia[(n - 1) * 50 / 100], copia[(n - 1) * 90 / 100],
+                   copia[(n - 1) * 99 / 100], copia[n - 1]);
+}
+
+/**
+ * Escreve na resposta os percentis de latência das duas janelas
+ */
+void respostaEstatisticas(Resposta *r) {
+    respostaPrintf(r, "OK 2\n");
+    respostaPercentis(r, "servico", &latencias.servico);
+    respostaPercentis(r, "ponta_a_ponta", &latencias.pontaAPonta);
+}
+
+/**
+ * Lê a direção opcional ("asc"/"desc") de um comando
+ * 
+ * @return 0 para crescente, 1 para decrescente, -1 se inválida
+ */
+int lerDirecao(const char *token) {
+    if (token == NULL || strcmp(token, "asc") == 0) return 0;
+    if (strcmp(token, "desc") == 0) return 1;
+    return -1;
+}
+
+/**
+ * Responde ORDENAR/TOP a partir das permutações pré-calculadas
+ */
+void respostaOrdenada(Resposta *r, int chave, int direcao, int limite) {
+    int *ordem = base.ordens[chave][direcao];
+    int n = limite < base.total ? limite : base.total;
+    
+    respostaPrintf(r, "OK %d\n", n);
+    for (int i = 0; i < n; i++) {
+        respostaJogador(r, &base.jogadores[ordem[i]]);
+    }
+}
+
+/**
+ * Responde PREFIXO com busca binária no índice em ordem de bytes
+ */
+void respostaPrefixo(Resposta *r, const char *prefixo) {
+    size_t tam = strlen(prefixo);
+    int *ordem = base.ordemPrefixo;
+    
+    // Primeiro nome >= prefixo
+    int lo = 0, hi = base.total;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (strncmp(base.jogadores[ordem[mid]].name, prefixo, tam) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    int fim = lo;
+    while (fim < base.total && strncmp(base.jogadores[ordem[fim]].name, prefixo, tam) == 0) {
+        fim++;
+    }
+    
+    respostaPrintf(r, "OK %d\n", fim - lo);
+    for (int i = lo; i < fim; i++) {
+        respostaJogador(r, &base.jogadores[ordem[i]]);
+    }
+}
+
+/**
+ * Responde AGRUPAR percorrendo a ordem crescente da chave e contando
+ * cada sequência de valores iguais
+ */
+void respostaAgrupada(Resposta *r, int chave) {
+    int *ordem = base.ordens[chave][0];
+    int grupos = 0;
+    
+    for (int i = 0; i < base.total; i++) {
+        if (i == 0 || compararPorChave(&base.jogadores[ordem[i - 1]], &base.jogadores[ordem[i]], chave) != 0) {
+            grupos++;
+        }
+    }
+    
+    respostaPrintf(r, "OK %d\n", grupos);
+    int i = 0;
+    while (i < base.total) {
+        int j = i + 1;
+        while (j < base.total &&
+               compararPorChave(&base.jogadores[ordem[i]], &base.jogadores[ordem[j]], chave) == 0) {
+            j++;
+        }
+        const player *p = &base.jogadores[ordem[i]];
+        if (chave == CHAVE_IDADE) {
+            respostaPrintf(r, "%d,%d\n", p->age, j - i);
+        } else {
+            respostaPrintf(r, "%s,%d\n", campoTexto(p, chave), j - i);
+        }
+        i = j;
+    }
+}
+
+/**
+ * Interpreta e executa uma linha do protocolo
+ * 
+ * @param linha Requisição (modificada durante a tokenização)
+ * @param r Resposta onde o resultado é acumulado
+ * @return 0 se a conexão deve ser encerrada, 1 caso contrário
+ */
+int executarComando(char *linha, Resposta *r) {
+    TRACE_ESCOPO("executarComando");
+    char *contexto;
+    char *comando = strtok_r(linha, " \t", &contexto);
+    
+    if (comando == NULL) {
+        respostaPrintf(r, "ERRO requisição vazia\n");
+        return 1;
+    }
+    
+    if (strcmp(comando, "ORDENAR") == 0 || strcmp(comando, "TOP") == 0) {
+        bool top = comando[0] == 'T';
+        char *nomeChave = strtok_r(NULL, " \t", &contexto);
+        int chave = nomeChave ? chavePorNome(nomeChave) : -1;
+        int limite = base.total;
+        
+        if (chave < 0) {
+            respostaPrintf(r, "ERRO chave inválida\n");
+            return 1;
+        }
+        if (top) {
+            char *k = strtok_r(NULL, " \t", &contexto);
+            char *fimNumero;
+            long valor = -1;
+            if (k != NULL) {
+                valor = strtol(k, &fimNumero, 10);
+                if (fimNumero == k || *fimNumero != '\0') valor = -1;  // Sobrou texto após o número
             }
-            campo++;
-            token = strtok(NULL, ",");
+            limite = valor > base.total ? base.total : (int)valor;
+            if (limite < 0) {
+                respostaPrintf(r, "ERRO k inválido\n");
+                return 1;
+            }
+        }
+        int direcao = lerDirecao(strtok_r(NULL, " \t", &contexto));
+        if (direcao < 0) {
+            respostaPrintf(r, "ERRO direção inválida (use asc ou desc)\n");
+            return 1;
         }
+        respostaOrdenada(r, chave, direcao, limite);
+    } else if (strcmp(comando, "PREFIXO") == 0) {
+        // O restante da linha é o prefixo (pode conter espaços)
+        while (*contexto == ' ' || *contexto == '\t') contexto++;
+        if (*contexto == '\0') {
+            respostaPrintf(r, "ERRO prefixo vazio\n");
+            return 1;
+        }
+        respostaPrefixo(r, contexto);
+    } else if (strcmp(comando, "AGRUPAR") == 0) {
+        char *nomeChave = strtok_r(NULL, " \t", &contexto);
+        int chave = nomeChave ? chavePorNome(nomeChave) : -1;
+        if (chave < 0) {
+            respostaPrintf(r, "ERRO chave inválida\n");
+            return 1;
+        }
+        respostaAgrupada(r, chave);
+    } else if (strcmp(comando, "ESTATISTICAS") == 0) {
+        respostaEstatisticas(r);
+    } else if (strcmp(comando, "SAIR") == 0) {
+        respostaPrintf(r, "OK 0\n");
+        return 0;
+    } else {
+        respostaPrintf(r, "ERRO comando desconhecido: %s\n", comando);
+    }
+    return 1;
+}
 
-        players[index].prox = NULL;
-        index++;
+/**
+ * Envia todo o conteúdo do buffer, tratando escritas parciais
+ */
+int enviarTudo(int fd, const char *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t enviado = write(fd, dados, tamanho);
+        if (enviado < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        dados += enviado;
+        tamanho -= enviado;
     }
+    return 1;
+}
+
+/**
+ * Processa todas as requisições completas recebidas numa conexão (pipeline)
+ * e as responde com uma única escrita
+ * 
+ * @param c Conexão entregue a este trabalhador
+ * @return 1 para manter a conexão aberta, 0 para encerrá-la
+ */
+int atenderLote(Conexao *c) {
+    Resposta resposta = {NULL, 0, 0, false};
+    int continuar = 1;
+    int pendentes = 0;            // Requisições respondidas ainda não enviadas
     
-    *total_players = count;
-    fclose(file);
-    return players;
+    char *inicio = c->buffer;
+    char *fimLinha;
+    while (continuar && (fimLinha = memchr(inicio, '\n', c->buffer + c->usado - inicio)) != NULL) {
+        *fimLinha = '\0';
+        if (fimLinha > inicio && fimLinha[-1] == '\r') fimLinha[-1] = '\0';
+        
+        size_t antes = resposta.tamanho;
+        double t0 = agoraMicrossegundos();
+        continuar = executarComando(inicio, &resposta);
+        registrarLatencia(&latencias.servico, agoraMicrossegundos() - t0, 1);
+        pendentes++;
+        
+        inicio = fimLinha + 1;
+        
+        // Resposta incompleta deixaria o cliente esperando linhas que não
+        // virão: descarta a parte deste comando, avisa e encerra a conexão
+        if (resposta.semMemoria) {
+            static const char erro[] = "ERRO memória\n";
+            if (enviarTudo(c->fd, resposta.dados, antes)) {
+                enviarTudo(c->fd, erro, sizeof(erro) - 1);
+            }
+            free(resposta.dados);
+            return 0;
+        }
+        
+        // Lote grande: envia o que já foi respondido para limitar a memória
+        if (resposta.tamanho >= LIMITE_RESPOSTA_LOTE) {
+            if (!enviarTudo(c->fd, resposta.dados, resposta.tamanho)) {
+                continuar = 0;
+            }
+            registrarLatencia(&latencias.pontaAPonta, agoraMicrossegundos() - c->recebido, pendentes);
+            resposta.tamanho = 0;
+            pendentes = 0;
+        }
+    }
+    
+    // Mantém no buffer a requisição ainda incompleta
+    c->usado -= inicio - c->buffer;
+    memmove(c->buffer, inicio, c->usado);
+    if (continuar && c->usado == sizeof(c->buffer) - 1) {
+        respostaPrintf(&resposta, "ERRO requisição muito longa\n");
+        continuar = 0;
+    }
+    
+    if (!enviarTudo(c->fd, resposta.dados, resposta.tamanho)) {
+        continuar = 0;
+    }
+    registrarLatencia(&latencias.pontaAPonta, agoraMicrossegundos() - c->recebido, pendentes);
+    free(resposta.dados);
+    return continuar;
 }
 
 /**
- * Função para liberar memória alocada para o vetor de jogadores
+ * Laço de cada thread do pool: retira lotes da fila, responde e devolve
+ * a conexão à thread principal
+ */
+void *trabalhador(void *arg) {
+    (void)arg;
+    
+    for (;;) {
+        pthread_mutex_lock(&fila.trava);
+        while (fila.tamanho == 0 && !fila.encerrando) {
+            pthread_cond_wait(&fila.naoVazia, &fila.trava);
+        }
+        if (fila.encerrando) {
+            pthread_mutex_unlock(&fila.trava);
+            return NULL;
+        }
+        Conexao *c = fila.lotes[fila.inicio];
+        fila.inicio = (fila.inicio + 1) % MAX_CONEXOES;
+        fila.tamanho--;
+        pthread_mutex_unlock(&fila.trava);
+        
+        int continuar = atenderLote(c);
+        
+        pthread_mutex_lock(&fila.trava);
+        c->encerrar = !continuar;
+        c->emAtendimento = false;
+        pthread_mutex_unlock(&fila.trava);
+        if (write(pipeRetorno[1], "x", 1) < 0) {
+            // Pipe cheio: a thread principal já tem avisos pendentes
+        }
+    }
+}
+
+/**
+ * Aceita uma conexão pendente, recusando-a se já houver MAX_CONEXOES abertas
+ */
+void aceitarConexao(int servidor) {
+    int cliente = accept(servidor, NULL, NULL);
+    if (cliente < 0) return;  // Cliente desistiu ou interrupção: o poll() tenta de novo
+    fcntl(cliente, F_SETFL, 0);  // Escritas bloqueantes, limitadas por SO_SNDTIMEO
+    
+    int livre = 0;
+    while (livre < MAX_CONEXOES && conexoes[livre] != NULL) livre++;
+    Conexao *c = livre < MAX_CONEXOES ? (Conexao*)malloc(sizeof(Conexao)) : NULL;
+    if (c == NULL) {
+        static const char erro[] = "ERRO servidor lotado\n";
+        enviarTudo(cliente, erro, sizeof(erro) - 1);
+        close(cliente);
+        return;
+    }
+    
+    // Cliente que não lê as respostas não prende o trabalhador para sempre
+    struct timeval limite = {TEMPO_ESCRITA_S, 0};
+    setsockopt(cliente, SOL_SOCKET, SO_SNDTIMEO, &limite, sizeof(limite));
+    c->fd = cliente;
+    c->usado = 0;
+    c->emAtendimento = false;
+    c->encerrar = false;
+    conexoes[livre] = c;
+}
+
+/**
+ * Lê o que chegou numa conexão ociosa e, havendo ao menos uma requisição
+ * completa (ou o buffer cheio), entrega o lote a um trabalhador
+ */
+void lerConexao(Conexao *c) {
+    ssize_t lido = read(c->fd, c->buffer + c->usado, sizeof(c->buffer) - 1 - c->usado);
+    if (lido < 0 && (errno == EINTR || errno == EAGAIN)) return;
+    if (lido <= 0) {
+        c->encerrar = true;  // Cliente encerrou a conexão
+        return;
+    }
+    c->usado += lido;
+    if (memchr(c->buffer + c->usado - lido, '\n', lido) == NULL && c->usado < sizeof(c->buffer) - 1) {
+        return;  // Requisição ainda incompleta
+    }
+    
+    c->recebido = agoraMicrossegundos();
+    pthread_mutex_lock(&fila.trava);
+    c->emAtendimento = true;
+    fila.lotes[(fila.inicio + fila.tamanho) % MAX_CONEXOES] = c;
+    fila.tamanho++;
+    pthread_cond_signal(&fila.naoVazia);
+    pthread_mutex_unlock(&fila.trava);
+}
+
+/**
+ * Fecha e libera uma conexão que não está com nenhum trabalhador
+ */
+void fecharConexao(int posicao) {
+    close(conexoes[posicao]->fd);
+    free(conexoes[posicao]);
+    conexoes[posicao] = NULL;
+}
+
+void tratarSinalEncerramento(int sinal) {
+    (void)sinal;
+    int errnoSalvo = errno;
+    servidorAtivo = 0;
+    if (write(pipeSinal[1], "x", 1) < 0) {
+        // Pipe cheio: já há um aviso pendente
+    }
+    errno = errnoSalvo;
+}
+
+/**
+ * Pré-calcula as permutações de todas as chaves nas duas direções
  * 
- * @param players Ponteiro para o vetor a ser liberado
+ * @return 1 em caso de sucesso, 0 se faltar memória
  */
-void liberarPlayers(player *players) {
-    free(players);
+int prepararBase(player *jogadores, int total) {
+    TRACE_ESCOPO("prepararBase");
+    base.jogadores = jogadores;
+    base.total = total;
+    
+    for (int c = 0; c < NUM_CHAVES; c++) {
+        for (int d = 0; d < 2; d++) {
+            base.ordens[c][d] = (int*)malloc(total * sizeof(int));
+            if (base.ordens[c][d] == NULL) return 0;
+            
+            // Reaproveita a permutação do cache quando disponível
+            const int *ordem = cacheBuscar(c, d, ORDEM_COMPARACAO);
+            if (ordem != NULL) {
+                memcpy(base.ordens[c][d], ordem, total * sizeof(int));
+                continue;
+            }
+            for (int i = 0; i < total; i++) base.ordens[c][d][i] = i;
+            if (!ordenarIndices(jogadores, base.ordens[c][d], total, compararPorChave, c, d ? -1 : 1)) {
+                return 0;
+            }
+            cacheGuardar(c, d, ORDEM_COMPARACAO, base.ordens[c][d]);
+        }
+    }
+    
+    base.ordemPrefixo = (int*)malloc(total * sizeof(int));
+    if (base.ordemPrefixo == NULL) return 0;
+    for (int i = 0; i < total; i++) base.ordemPrefixo[i] = i;
+    return ordenarIndices(jogadores, base.ordemPrefixo, total, compararNomeBytes, CHAVE_NOME, 1);
 }
 
 /**
- * Função para verificar se um arquivo existe
+ * Libera as permutações pré-calculadas (os jogadores pertencem ao chamador)
+ */
+void liberarBase() {
+    for (int c = 0; c < NUM_CHAVES; c++) {
+        free(base.ordens[c][0]);
+        free(base.ordens[c][1]);
+    }
+    free(base.ordemPrefixo);
+}
+
+/**
+ * Executa o servidor até receber SIGINT ou SIGTERM
  * 
- * @param filename Nome do arquivo
- * @return 1 se existe, 0 se não existe
+ * @param jogadores Vetor de jogadores já carregado
+ * @param total Número total de jogadores
+ * @param caminhoSocket Caminho do socket Unix
+ * @param numTrabalhadores Threads do pool (1 a MAX_TRABALHADORES)
+ * @return 0 em caso de sucesso, 1 em caso de erro
  */
-int arquivoExiste(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (file) {
-        fclose(file);
+int executarServidor(player *jogadores, int total, const char *caminhoSocket, int numTrabalhadores) {
+    if (!prepararBase(jogadores, total)) {
+        printf("Erro ao alocar memória para os índices\n");
+        liberarBase();
+        return 1;
+    }
+    
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0) {
+        perror("socket");
+        liberarBase();
+        return 1;
+    }
+    
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strncpy(endereco.sun_path, caminhoSocket, sizeof(endereco.sun_path) - 1);
+    unlink(caminhoSocket);  // Remove socket antigo, se houver
+    
+    if (bind(servidor, (struct sockaddr*)&endereco, sizeof(endereco)) < 0 || listen(servidor, MAX_CONEXOES) < 0) {
+        perror("bind/listen");
+        close(servidor);
+        liberarBase();
+        return 1;
+    }
+    
+    // O sinal escreve no pipe, que é monitorado junto com o socket: não há
+    // janela entre verificar servidorAtivo e bloquear em que o sinal se perca
+    if (pipe(pipeSinal) < 0 || pipe(pipeRetorno) < 0) {
+        perror("pipe");
+        close(servidor);
+        liberarBase();
         return 1;
     }
+    for (int i = 0; i < 2; i++) {
+        fcntl(pipeSinal[i], F_SETFL, O_NONBLOCK);
+        fcntl(pipeRetorno[i], F_SETFL, O_NONBLOCK);
+    }
+    fcntl(servidor, F_SETFL, O_NONBLOCK);  // accept() não bloqueia se o cliente desistir
+    
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = tratarSinalEncerramento;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+    signal(SIGPIPE, SIG_IGN);  // Cliente que fecha cedo não derruba o servidor
+    
+    // As threads herdam a máscara com SIGINT/SIGTERM bloqueados, garantindo
+    // que o sinal seja entregue à thread principal
+    sigset_t sinais, mascaraAnterior;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sinais, &mascaraAnterior);
+    
+    pthread_t threads[MAX_TRABALHADORES];
+    for (int i = 0; i < numTrabalhadores; i++) {
+        pthread_create(&threads[i], NULL, trabalhador, NULL);
+    }
+    pthread_sigmask(SIG_SETMASK, &mascaraAnterior, NULL);
+    
+    printf("Servidor ouvindo em %s (%d jogadores, %d threads, cache: %lld acertos / %lld falhas)\n",
+           caminhoSocket, total, numTrabalhadores, cache.acertos, cache.falhas);
+    fflush(stdout);
+    
+    // A thread principal monitora todas as conexões ociosas; os trabalhadores
+    // só recebem lotes completos, então clientes parados não ocupam o pool
+    static struct pollfd pfds[3 + MAX_CONEXOES];
+    static Conexao *alvos[3 + MAX_CONEXOES];
+    while (servidorAtivo) {
+        int n = 0;
+        pfds[n++] = (struct pollfd){pipeSinal[0], POLLIN, 0};
+        pfds[n++] = (struct pollfd){pipeRetorno[0], POLLIN, 0};
+        pfds[n++] = (struct pollfd){servidor, POLLIN, 0};
+        
+        pthread_mutex_lock(&fila.trava);
+        for (int i = 0; i < MAX_CONEXOES; i++) {
+            if (conexoes[i] == NULL || conexoes[i]->emAtendimento) continue;
+            if (conexoes[i]->encerrar) {
+                fecharConexao(i);
+                continue;
+            }
+            alvos[n] = conexoes[i];
+            pfds[n++] = (struct pollfd){conexoes[i]->fd, POLLIN, 0};
+        }
+        pthread_mutex_unlock(&fila.trava);
+        
+        if (poll(pfds, n, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        if (pfds[0].revents & POLLIN) {
+            break;  // Sinal de encerramento
+        }
+        if (pfds[1].revents & POLLIN) {
+            char descarte[64];
+            while (read(pipeRetorno[0], descarte, sizeof(descarte)) > 0) {
+                // Só esvazia o pipe: a próxima volta recoloca as conexões no poll()
+            }
+        }
+        if (pfds[2].revents & POLLIN) {
+            aceitarConexao(servidor);
+        }
+        for (int i = 3; i < n; i++) {
+            if (pfds[i].revents != 0) {
+                lerConexao(alvos[i]);
+            }
+        }
+    }
+    
+    // Encerramento: descarta os lotes na fila e interrompe as respostas em
+    // andamento, para que nenhum trabalhador fique preso num cliente lento
+    pthread_mutex_lock(&fila.trava);
+    fila.encerrando = true;
+    for (int i = 0; i < MAX_CONEXOES; i++) {
+        if (conexoes[i] != NULL && conexoes[i]->emAtendimento) {
+            shutdown(conexoes[i]->fd, SHUT_RDWR);
+        }
+    }
+    pthread_cond_broadcast(&fila.naoVazia);
+    pthread_mutex_unlock(&fila.trava);
+    for (int i = 0; i < numTrabalhadores; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (int i = 0; i < MAX_CONEXOES; i++) {
+        if (conexoes[i] != NULL) fecharConexao(i);
+    }
+    
+    close(servidor);
+    close(pipeSinal[0]);
+    close(pipeSinal[1]);
+    close(pipeRetorno[0]);
+    close(pipeRetorno[1]);
+    unlink(caminhoSocket);
+    liberarBase();
+    
+    Resposta r = {NULL, 0, 0, false};
+    respostaEstatisticas(&r);
+    printf("\nServidor encerrado.\n%s", r.dados ? r.dados + strlen("OK 2\n") : "");
+    free(r.dados);
     return 0;
 }
 
+/**
+ * Cliente local para testar o servidor
+ * Envia o comando da linha de comando, ou todas as linhas da entrada padrão
+ * de uma só vez (pipeline), e imprime as respostas
+ * 
+ * @param caminhoSocket Caminho do socket Unix
+ * @param argc Número de palavras do comando
+ * @param argv Palavras do comando (vazio para ler da entrada padrão)
+ * @return 0 em caso de sucesso, 1 em caso de erro
+ */
+int executarCliente(const char *caminhoSocket, int argc, char *argv[]) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strncpy(endereco.sun_path, caminhoSocket, sizeof(endereco.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) < 0) {
+        printf("Erro ao conectar em %s: %s\n", caminhoSocket, strerror(errno));
+        close(fd);
+        return 1;
+    }
+    
+    Resposta envio = {NULL, 0, 0, false};
+    if (argc > 0) {
+        for (int i = 0; i < argc; i++) {
+            respostaPrintf(&envio, i ? " %s" : "%s", argv[i]);
+        }
+        respostaPrintf(&envio, "\n");
+    } else {
+        char linha[TAM_BUFFER_LEITURA];
+        while (fgets(linha, sizeof(linha), stdin) != NULL) {
+            respostaPrintf(&envio, "%s", linha);
+        }
+        if (envio.tamanho > 0 && envio.dados[envio.tamanho - 1] != '\n') {
+            respostaPrintf(&envio, "\n");
+        }
+    }
+    
+    if (envio.semMemoria) {
+        printf("Erro ao alocar memória para as requisições\n");
+        free(envio.dados);
+        close(fd);
+        return 1;
+    }
+    
+    // Envia e recebe ao mesmo tempo: se o cliente só lesse depois de enviar
+    // tudo, o servidor travaria escrevendo respostas num socket cheio
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    size_t enviado = 0;
+    int ok = 1;
+    bool envioFechado = false;
+    char buffer[TAM_BUFFER_LEITURA];
+    
+    for (;;) {
+        if (!envioFechado && enviado == envio.tamanho) {
+            shutdown(fd, SHUT_WR);  // Sinaliza fim das requisições
+            envioFechado = true;
+        }
+        
+        struct pollfd pfd = {fd, POLLIN | (envioFechado ? 0 : POLLOUT), 0};
+        if (poll(&pfd, 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            ok = 0;
+            break;
+        }
+        
+        if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t lido = read(fd, buffer, sizeof(buffer));
+            if (lido > 0) {
+                fwrite(buffer, 1, lido, stdout);
+            } else if (lido == 0) {
+                break;  // Servidor encerrou a conexão
+            } else if (errno != EAGAIN && errno != EINTR) {
+                ok = 0;
+                break;
+            }
+        }
+        
+        if (!envioFechado && (pfd.revents & POLLOUT)) {
+            ssize_t escrito = write(fd, envio.dados + enviado, envio.tamanho - enviado);
+            if (escrito > 0) {
+                enviado += escrito;
+            } else if (escrito < 0 && errno != EAGAIN && errno != EINTR) {
+                ok = 0;
+                break;
+            }
+        }
+    }
+    
+    free(envio.dados);
+    close(fd);
+    return ok ? 0 : 1;
+}
+
 // ============================================================================
 // FUNÇÃO PRINCIPAL
 // ============================================================================
@@ -684,15 +2519,66 @@ int arquivoExiste(const char *filename) {
 /**
  * Função principal do programa
  * Coordena todo o fluxo de execução
+ * 
+ * Uso:
+ *   ./main [--cache]                             menu interativo
+ *   ./main [--cache] --servidor [socket] [threads]  modo servidor
+ *   ./main --cliente [socket] [comando]          envia comando(s) ao servidor
+ * 
+ * --cache grava as ordenações calculadas ao lado do CSV (jogadores.csv.cache)
+ * e as reaproveita na próxima execução; threads define o tamanho do pool
+ * (padrão TRABALHADORES_PADRAO, no máximo MAX_TRABALHADORES)
  */
-int main() {
+int main(int argc, char *argv[]) {
+    const char *programa = argv[0];
+    bool cacheEmDisco = argc > 1 && strcmp(argv[1], "--cache") == 0;
+    if (cacheEmDisco) {
+        argv++;
+        argc--;
+    }
+    
+    bool modoServidor = argc > 1 && strcmp(argv[1], "--servidor") == 0;
+    bool modoCliente = argc > 1 && strcmp(argv[1], "--cliente") == 0;
+    
+    if (argc > 1 && !modoServidor && !modoCliente) {
+        printf("Uso: %s [--cache] [--servidor [socket] [threads]] | --cliente [socket] [comando...]\n", programa);
+        return 1;
+    }
+    
     // Configura locale para suporte a caracteres acentuados
     setlocale(LC_ALL, "pt_BR.UTF-8");
+    
+    // Caminho do socket: argumento opcional começando com '/' ou '.'
+    const char *caminhoSocket = SOCKET_PADRAO;
+    int proximoArg = 2;
+    if (argc > 2 && (argv[2][0] == '/' || argv[2][0] == '.')) {
+        caminhoSocket = argv[2];
+        proximoArg = 3;
+    }
+    
+    if (modoCliente) {
+        return executarCliente(caminhoSocket, argc - proximoArg, argv + proximoArg);
+    }
+    
+    int numTrabalhadores = TRABALHADORES_PADRAO;
+    if (modoServidor && argc > proximoArg) {
+        char *fim;
+        long valor = strtol(argv[proximoArg], &fim, 10);
+        if (argc > proximoArg + 1 || *fim != '\0' || valor < 1 || valor > MAX_TRABALHADORES) {
+            printf("Uso: %s [--cache] --servidor [socket] [threads], com threads de 1 a %d\n",
+                   programa, MAX_TRABALHADORES);
+            return 1;
+        }
+        numTrabalhadores = (int)valor;
+    }
+    
     printf("Locale configurado para: %s\n", setlocale(LC_ALL, NULL));
     
     printf("Carregando dados do arquivo...\n");
     
     const char* caminho_arquivo = "../jogadores.csv";
+    char caminho_cache[300];
+    snprintf(caminho_cache, sizeof(caminho_cache), "%s.cache", caminho_arquivo);
     
     // Verifica se arquivo existe
     if (!arquivoExiste(caminho_arquivo)) {
@@ -711,22 +2597,40 @@ int main() {
     
     printf("Dados carregados com sucesso! Total de jogadores: %d\n", total);
     
+    // Associa o cache de ordenações aos dados recém-carregados
+    cacheVincular(jogadores, total);
+    if (cacheEmDisco) {
+        printf("Ordenações carregadas do cache: %d\n", cacheCarregar(caminho_cache));
+    }
+    
+    if (modoServidor) {
+        int status = executarServidor(jogadores, total, caminhoSocket, numTrabalhadores);
+        if (cacheEmDisco) cacheSalvar(caminho_cache);
+        cacheInvalidar();
+        liberarPlayers(jogadores);
+        TRACE_EXPORTAR(ARQUIVO_TRACE);
+        return status;
+    }
+    
     // Loop principal do menu
     int opcao;
     do {
         exibirMenu();
         scanf("%d", &opcao);
         
-        if (opcao >= 1 && opcao <= 3) {
+        if (opcao >= 1 && opcao <= 7) {
             processarOrdenacao(jogadores, total, opcao);
-        } else if (opcao != 4) {
+        } else if (opcao != 0) {
             printf("Opção inválida! Tente novamente.\n");
         }
         
-    } while (opcao != 4);  // Repete até usuário escolher sair
+    } while (opcao != 0);  // Repete até usuário escolher sair
     
     // Libera memória e encerra programa
+    if (cacheEmDisco) cacheSalvar(caminho_cache);
+    cacheInvalidar();
     liberarPlayers(jogadores);
+    TRACE_EXPORTAR(ARQUIVO_TRACE);
     printf("Programa encerrado.\n");
     
     return 0;